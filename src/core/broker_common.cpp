@@ -19,6 +19,7 @@
 
 #include "broker_common.h"
 #include "etcpal/cpp/log.h"
+#include "broker_flight_recorder.h"
 #include <cassert>
 
 class AssertLogHandler : public etcpal::LogMessageHandler
@@ -52,6 +53,10 @@ bool AssertVerifyFail(const char*                             exp,
   logger.Critical(R"(ASSERTION "%s" FAILED (FILE: "%s" FUNCTION: "%s" LINE: %d))", exp ? exp : "", file ? file : "",
                   func ? func : "", line);
 
+  // Preserve the events leading up to the failure before a debug build aborts below.
+  BrokerFlightRecorder::Get().Record(BrokerEvent::kAssertFailed, static_cast<uint32_t>(line));
+  BrokerFlightRecorder::Get().DumpToFile();
+
   assert(false);
   return false;
 }
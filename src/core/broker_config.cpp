@@ -329,7 +329,10 @@ bool ValidateAndStoreLogLevel(const json& val, BrokerConfig& config, etcpal::Log
 //   "max_controller_messages": 500,
 //   "max_devices": 20000,
 //   "max_device_messages": 500,
-//   "max_reject_connections": 1000
+//   "max_reject_connections": 1000,
+//
+//   "overload_enter_lag_ms": 1000,
+//   "overload_exit_lag_ms": 250
 // }
 // Any or all of these items can be omitted to use the default value for that key.
 
@@ -460,6 +463,22 @@ static const Validator kSettingsValidatorArray[] = {
       return true;
     },
     [](auto& config) { config.enable_broker = true; }
+  },
+  {
+    "/overload_enter_lag_ms"_json_pointer,
+    json::value_t::number_unsigned,
+    [](const json& val, auto& config, auto log) {
+      return ValidateAndStoreInt<unsigned int>("/overload_enter_lag_ms", val, config.overload_enter_lag_ms, log);
+    },
+    [](auto& config) { config.overload_enter_lag_ms = 1000; }
+  },
+  {
+    "/overload_exit_lag_ms"_json_pointer,
+    json::value_t::number_unsigned,
+    [](const json& val, auto& config, auto log) {
+      return ValidateAndStoreInt<unsigned int>("/overload_exit_lag_ms", val, config.overload_exit_lag_ms, log);
+    },
+    [](auto& config) { config.overload_exit_lag_ms = 250; }
   }
 };
 // clang-format on
@@ -47,6 +47,8 @@ public:
   rdmnet::Broker::Settings settings;
   int                      log_mask;
   bool                     enable_broker;
+  unsigned int             overload_enter_lag_ms;
+  unsigned int             overload_exit_lag_ms;
 
   [[nodiscard]] ParseResult Read(std::istream& stream, etcpal::Logger* log = nullptr);
   void                      SetDefaults();
@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#include "broker_flight_recorder.h"
+
+#include <cerrno>
+#include <cstring>
+#include "etcpal/timer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using FileHandle = BrokerFlightRecorder::FileHandle;
+
+constexpr const char kDumpMagic[8] = {'R', 'D', 'M', 'B', 'F', 'R', '0', '1'};
+
+// Records are written in batches of this many, from a buffer on the stack.
+static constexpr size_t kDumpBatchSize = 64u;
+
+// Thin wrappers over the OS file API. These go straight to system calls: unlike stdio or the
+// MSVC CRT's low-level I/O functions, they neither allocate nor take process-wide locks.
+static bool OpenDumpFile(const BrokerFlightRecorder::PathString::value_type* path, FileHandle& file)
+{
+#ifdef _WIN32
+  file = CreateFileW(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  return file != INVALID_HANDLE_VALUE;
+#else
+  file = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  return file >= 0;
+#endif
+}
+
+static bool CloseDumpFile(FileHandle file)
+{
+#ifdef _WIN32
+  return CloseHandle(file) != 0;
+#else
+  return close(file) == 0;
+#endif
+}
+
+static bool WriteAll(FileHandle file, const void* data, size_t size)
+{
+  const char* bytes = static_cast<const char*>(data);
+  while (size > 0)
+  {
+#ifdef _WIN32
+    DWORD written = 0;
+    if (!WriteFile(file, bytes, static_cast<DWORD>(size), &written, nullptr) || (written == 0))
+      return false;
+#else
+    const ssize_t written = write(file, bytes, size);
+    if ((written < 0) && (errno == EINTR))
+      continue;
+    if (written <= 0)
+      return false;
+#endif
+    bytes += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+BrokerFlightRecorder& BrokerFlightRecorder::Get()
+{
+  static BrokerFlightRecorder instance;
+  return instance;
+}
+
+void BrokerFlightRecorder::Record(BrokerEvent event, uint32_t arg1, uint32_t arg2)
+{
+  Record(event, arg1, arg2, etcpal_getms());
+}
+
+void BrokerFlightRecorder::Record(BrokerEvent event, uint32_t arg1, uint32_t arg2, uint32_t now_ms)
+{
+  const uint64_t sequence = next_sequence_.fetch_add(1u, std::memory_order_relaxed);
+  Slot&          slot = slots_[sequence & (kCapacity - 1)];
+
+  // Mark the slot as being written before touching its fields, then publish it.
+  slot.sequence.store(0u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.time_ms.store(now_ms, std::memory_order_relaxed);
+  slot.event.store(static_cast<uint32_t>(event), std::memory_order_relaxed);
+  slot.arg1.store(arg1, std::memory_order_relaxed);
+  slot.arg2.store(arg2, std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1u, std::memory_order_release);
+}
+
+// Set the file that DumpToFile() writes to. This should be called once at startup, before any
+// thread that might dump is running.
+void BrokerFlightRecorder::SetDumpPath(const PathString& path)
+{
+  if (path.empty() || path.size() >= dump_path_.size())
+    return;
+
+  std::memcpy(dump_path_.data(), path.c_str(), (path.size() + 1) * sizeof(PathString::value_type));
+  dump_path_set_ = true;
+}
+
+// Write the current contents of the ring to the dump path, replacing any previous dump. This
+// neither allocates nor takes locks, so it may be called from a fatal signal or unhandled
+// exception handler.
+bool BrokerFlightRecorder::DumpToFile()
+{
+  if (!dump_path_set_)
+    return false;
+
+  FileHandle file;
+  if (!OpenDumpFile(dump_path_.data(), file))
+    return false;
+
+  const bool result = Dump(file);
+  return CloseDumpFile(file) && result;
+}
+
+// Dump to the dump path if RequestDump() has been called since the last check. This is polled
+// by the watchdog thread.
+bool BrokerFlightRecorder::DumpIfRequested()
+{
+  if (!dump_requested_.exchange(false, std::memory_order_relaxed))
+    return false;
+  return DumpToFile();
+}
+
+bool BrokerFlightRecorder::Dump(FileHandle file) const
+{
+  const uint32_t header_fields[2] = {static_cast<uint32_t>(sizeof(DumpRecord)), 0u};
+  if (!WriteAll(file, kDumpMagic, sizeof(kDumpMagic)) || !WriteAll(file, header_fields, sizeof(header_fields)))
+    return false;
+
+  DumpRecord batch[kDumpBatchSize];
+  size_t     batch_count = 0;
+
+  const uint64_t end = next_sequence_.load(std::memory_order_acquire);
+  const uint64_t begin = (end > kCapacity) ? end - kCapacity : 0u;
+  for (uint64_t sequence = begin; sequence < end; ++sequence)
+  {
+    const Slot& slot = slots_[sequence & (kCapacity - 1)];
+
+    DumpRecord record{};
+    if (slot.sequence.load(std::memory_order_acquire) != sequence + 1u)
+      continue;  // Being written, or already overwritten by a newer event
+    record.sequence = sequence;
+    record.time_ms = slot.time_ms.load(std::memory_order_relaxed);
+    record.event = static_cast<uint16_t>(slot.event.load(std::memory_order_relaxed));
+    record.arg1 = slot.arg1.load(std::memory_order_relaxed);
+    record.arg2 = slot.arg2.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence + 1u)
+      continue;  // Overwritten while we were reading it
+
+    batch[batch_count++] = record;
+    if (batch_count == kDumpBatchSize)
+    {
+      if (!WriteAll(file, batch, sizeof(batch)))
+        return false;
+      batch_count = 0;
+    }
+  }
+
+  return WriteAll(file, batch, batch_count * sizeof(DumpRecord));
+}
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#ifndef BROKER_FLIGHT_RECORDER_H_
+#define BROKER_FLIGHT_RECORDER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// The kinds of events kept by the flight recorder. Values are part of the dump format and must
+// not be renumbered.
+enum class BrokerEvent : uint16_t
+{
+  kServiceStart = 1,       // args unused
+  kServiceStop = 2,        // args unused
+  kBrokerStarted = 3,      // args unused
+  kBrokerStartFailed = 4,  // arg1: etcpal_error_t
+  kBrokerStopped = 5,      // args unused
+  kRestartRequested = 6,   // arg1: cooldown applied (ms)
+  kRestart = 7,            // arg1: restarts in the last rate window
+  kConfigLoaded = 8,       // arg1: BrokerConfig::ParseResult
+  kScopeChanged = 9,       // args unused
+  kLoopStall = 10,         // arg1: watchdog loop handle, arg2: time since last beat (ms)
+  kAssertFailed = 11,      // arg1: source line
+  kOverloadEntered = 12,   // arg1: scheduling lag (ms)
+  kOverloadExited = 13,    // arg1: time spent overloaded (ms)
+  kRestartDeferred = 14,   // args unused
+};
+
+// BrokerFlightRecorder : An always-on, fixed-size ring of recent service events.
+//
+// Recording an event is lock-free and allocation-free, so it is cheap enough to leave on
+// permanently. Once the ring is full, the oldest events are overwritten. The ring is dumped to a
+// file on a fatal signal, on a BROKER_ASSERT_VERIFY failure or on request. Dumping uses only
+// the OS's file calls (open()/write(), or CreateFileW()/WriteFile() on Windows) on a preallocated
+// path, so it is safe to do from a fatal signal or unhandled exception handler.
+// On-demand dumps from a signal handler should go through RequestDump() instead, which defers the
+// dump to the watchdog thread.
+//
+// Dump format (fields in host byte order):
+//   Header: char magic[8] = "RDMBFR01", uint32_t record_size, uint32_t reserved
+//   Followed by DumpRecords, oldest first, until the end of the file.
+class BrokerFlightRecorder
+{
+public:
+  static constexpr size_t kCapacity = 4096u;  // Must be a power of 2
+
+  // Dump paths are in the platform's native encoding, so that no conversion is needed to open them.
+#ifdef _WIN32
+  using PathString = std::wstring;
+  using FileHandle = void*;  // HANDLE
+#else
+  using PathString = std::string;
+  using FileHandle = int;  // File descriptor
+#endif
+
+  struct DumpRecord
+  {
+    uint64_t sequence;
+    uint32_t time_ms;
+    uint16_t event;
+    uint16_t reserved;
+    uint32_t arg1;
+    uint32_t arg2;
+  };
+  static_assert(sizeof(DumpRecord) == 24, "DumpRecord must not contain padding");
+
+  static BrokerFlightRecorder& Get();
+
+  void Record(BrokerEvent event, uint32_t arg1 = 0u, uint32_t arg2 = 0u);
+  void Record(BrokerEvent event, uint32_t arg1, uint32_t arg2, uint32_t now_ms);
+
+  void SetDumpPath(const PathString& path);
+  bool DumpToFile();
+  bool Dump(FileHandle file) const;
+
+  void RequestDump() { dump_requested_.store(true, std::memory_order_relaxed); }
+  bool DumpIfRequested();
+
+  [[nodiscard]] uint64_t total_recorded() const { return next_sequence_.load(std::memory_order_relaxed); }
+
+private:
+  static_assert((kCapacity & (kCapacity - 1)) == 0, "kCapacity must be a power of 2");
+
+  // Every field is atomic so that a dump taken while other threads are recording never reads a
+  // torn value. sequence is 0 while a slot is being written, and sequence + 1 once it is complete.
+  struct Slot
+  {
+    std::atomic<uint64_t> sequence{0u};
+    std::atomic<uint32_t> time_ms{0u};
+    std::atomic<uint32_t> event{0u};
+    std::atomic<uint32_t> arg1{0u};
+    std::atomic<uint32_t> arg2{0u};
+  };
+
+  std::atomic<uint64_t>                    next_sequence_{0u};
+  std::array<Slot, kCapacity>              slots_;
+  std::array<PathString::value_type, 1024> dump_path_{};  // Fixed storage so the path is usable from a signal handler
+  std::atomic<bool>                        dump_path_set_{false};
+  std::atomic<bool>                        dump_requested_{false};
+};
+
+#endif  // BROKER_FLIGHT_RECORDER_H_
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#include "broker_overload_monitor.h"
+
+#include <algorithm>
+
+void BrokerOverloadMonitor::SetThresholds(uint32_t enter_lag_ms, uint32_t exit_lag_ms)
+{
+  enter_lag_ms_ = enter_lag_ms;
+  exit_lag_ms_ = std::min(exit_lag_ms, enter_lag_ms);
+}
+
+// Feed in a new lag sample. Returns whether this sample caused the service to enter or leave
+// overload.
+BrokerOverloadMonitor::Transition BrokerOverloadMonitor::Update(uint32_t lag_ms, uint32_t now_ms)
+{
+  if (enter_lag_ms_ == 0u)
+  {
+    // Detection is disabled; make sure we don't stay stuck in overload if it was just turned off.
+    consecutive_high_samples_ = 0u;
+    if (overloaded_)
+    {
+      overloaded_ = false;
+      return Transition::kExited;
+    }
+    return Transition::kNone;
+  }
+
+  if (!overloaded_)
+  {
+    consecutive_high_samples_ = (lag_ms >= enter_lag_ms_) ? consecutive_high_samples_ + 1u : 0u;
+    if (consecutive_high_samples_ >= kEnterSamples)
+    {
+      overloaded_ = true;
+      overloaded_since_ms_ = now_ms;
+      consecutive_high_samples_ = 0u;
+      calm_ = false;
+      return Transition::kEntered;
+    }
+    return Transition::kNone;
+  }
+
+  if (lag_ms > exit_lag_ms_)
+  {
+    calm_ = false;
+    return Transition::kNone;
+  }
+
+  if (!calm_)
+  {
+    calm_ = true;
+    calm_since_ms_ = now_ms;
+  }
+
+  if ((now_ms - calm_since_ms_) >= kExitHoldMs)
+  {
+    overloaded_ = false;
+    calm_ = false;
+    return Transition::kExited;
+  }
+
+  return Transition::kNone;
+}
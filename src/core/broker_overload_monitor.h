@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#ifndef BROKER_OVERLOAD_MONITOR_H_
+#define BROKER_OVERLOAD_MONITOR_H_
+
+#include <cstdint>
+
+// BrokerOverloadMonitor : Decides when the service is overloaded, based on scheduling lag samples.
+//
+// The service enters overload once kEnterSamples consecutive samples reach the enter threshold. It
+// leaves overload only after every sample has stayed at or below the (lower) exit threshold for
+// kExitHoldMs. The gap between the two thresholds and the hold time provide hysteresis, so the
+// state doesn't flap. An enter threshold of 0 disables overload detection.
+class BrokerOverloadMonitor
+{
+public:
+  static constexpr uint32_t kEnterSamples = 2u;
+  static constexpr uint32_t kExitHoldMs = 10000u;
+
+  enum class Transition
+  {
+    kNone,
+    kEntered,
+    kExited
+  };
+
+  void SetThresholds(uint32_t enter_lag_ms, uint32_t exit_lag_ms);
+
+  Transition Update(uint32_t lag_ms, uint32_t now_ms);
+
+  [[nodiscard]] bool     overloaded() const { return overloaded_; }
+  [[nodiscard]] uint32_t overloaded_since_ms() const { return overloaded_since_ms_; }
+
+private:
+  uint32_t enter_lag_ms_{0u};
+  uint32_t exit_lag_ms_{0u};
+
+  bool     overloaded_{false};
+  uint32_t overloaded_since_ms_{0u};
+  uint32_t consecutive_high_samples_{0u};
+  bool     calm_{false};  // Whether samples have stayed at or below the exit threshold since calm_since_ms_
+  uint32_t calm_since_ms_{0u};
+};
+
+#endif  // BROKER_OVERLOAD_MONITOR_H_
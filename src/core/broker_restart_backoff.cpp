@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#include "broker_restart_backoff.h"
+
+#include <algorithm>
+
+BrokerRestartBackoff::BrokerRestartBackoff(uint32_t initial_backoff_ms,
+                                           uint32_t max_backoff_ms,
+                                           uint32_t quiet_period_ms)
+    : initial_backoff_ms_(initial_backoff_ms)
+    , max_backoff_ms_(std::max(max_backoff_ms, initial_backoff_ms))
+    , quiet_period_ms_(quiet_period_ms)
+{
+}
+
+// Register a restart trigger and return the cooldown (in ms) that should be applied before the
+// restart actually happens. The result is never shorter than requested_cooldown_ms.
+uint32_t BrokerRestartBackoff::OnRestartRequested(uint32_t now_ms, uint32_t requested_cooldown_ms)
+{
+  // Unsigned subtraction keeps these comparisons correct across wraparound of the ms clock.
+  if (have_last_request_ && (now_ms - last_request_ms_) >= quiet_period_ms_)
+    backoff_ms_ = 0u;
+
+  if (have_last_restart_ && !escalated_since_restart_ && (now_ms - last_restart_ms_) < quiet_period_ms_)
+  {
+    // We restarted recently and are already being asked to do it again - something is flapping.
+    escalated_since_restart_ = true;
+    if (backoff_ms_ == 0u)
+      backoff_ms_ = initial_backoff_ms_;
+    else
+      backoff_ms_ = (backoff_ms_ > max_backoff_ms_ / 2u) ? max_backoff_ms_ : backoff_ms_ * 2u;
+  }
+
+  have_last_request_ = true;
+  last_request_ms_ = now_ms;
+
+  return std::max(requested_cooldown_ms, backoff_ms_);
+}
+
+// Register that a restart has actually taken place.
+void BrokerRestartBackoff::OnRestart(uint32_t now_ms)
+{
+  have_last_restart_ = true;
+  last_restart_ms_ = now_ms;
+  escalated_since_restart_ = false;
+
+  restart_times_[next_restart_slot_] = now_ms;
+  next_restart_slot_ = (next_restart_slot_ + 1u) % kMaxTrackedRestarts;
+  ++total_restarts_;
+}
+
+// Get the number of restarts that have taken place within the last kRateWindowMs. Saturates at the
+// number of restart times tracked.
+size_t BrokerRestartBackoff::RestartsInWindow(uint32_t now_ms) const
+{
+  const size_t num_tracked = static_cast<size_t>(std::min<uint64_t>(total_restarts_, kMaxTrackedRestarts));
+  return static_cast<size_t>(std::count_if(restart_times_.begin(), restart_times_.begin() + num_tracked,
+                                           [now_ms](uint32_t time) { return (now_ms - time) < kRateWindowMs; }));
+}
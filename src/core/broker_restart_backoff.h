@@ -0,0 +1,74 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#ifndef BROKER_RESTART_BACKOFF_H_
+#define BROKER_RESTART_BACKOFF_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// BrokerRestartBackoff : Decides how long a requested broker restart should be held off.
+//
+// Restart triggers (network changes, config file writes, scope changes) that keep arriving shortly
+// after a restart indicate something flapping. The first such trigger after each restart doubles
+// the back-off, up to a cap; triggers often arrive in bursts, so the rest of a burst doesn't
+// escalate it further. Once no triggers have arrived for the quiet period, the back-off resets.
+// All times are in milliseconds from a monotonic clock (e.g. etcpal_getms()) and are passed in, to
+// keep this class independent of the system clock.
+class BrokerRestartBackoff
+{
+public:
+  static constexpr uint32_t kDefaultInitialBackoffMs = 5000u;
+  static constexpr uint32_t kDefaultMaxBackoffMs = 120000u;
+  static constexpr uint32_t kDefaultQuietPeriodMs = 60000u;
+  static constexpr uint32_t kRateWindowMs = 600000u;  // Restart rate is reported over the last 10 minutes
+
+  BrokerRestartBackoff(uint32_t initial_backoff_ms = kDefaultInitialBackoffMs,
+                       uint32_t max_backoff_ms = kDefaultMaxBackoffMs,
+                       uint32_t quiet_period_ms = kDefaultQuietPeriodMs);
+
+  uint32_t OnRestartRequested(uint32_t now_ms, uint32_t requested_cooldown_ms = 0u);
+  void     OnRestart(uint32_t now_ms);
+
+  [[nodiscard]] uint32_t current_backoff_ms() const { return backoff_ms_; }
+  [[nodiscard]] size_t   RestartsInWindow(uint32_t now_ms) const;
+  [[nodiscard]] uint64_t total_restarts() const { return total_restarts_; }
+
+private:
+  static constexpr size_t kMaxTrackedRestarts = 64u;
+
+  const uint32_t initial_backoff_ms_;
+  const uint32_t max_backoff_ms_;
+  const uint32_t quiet_period_ms_;
+
+  uint32_t backoff_ms_{0u};
+  bool     have_last_request_{false};
+  uint32_t last_request_ms_{0u};
+  bool     have_last_restart_{false};
+  uint32_t last_restart_ms_{0u};
+  bool     escalated_since_restart_{false};
+
+  // Ring of the most recent restart times, for reporting the restart rate.
+  std::array<uint32_t, kMaxTrackedRestarts> restart_times_{};
+  size_t                                    next_restart_slot_{0u};
+  uint64_t                                  total_restarts_{0u};
+};
+
+#endif  // BROKER_RESTART_BACKOFF_H_
@@ -21,11 +21,20 @@
 
 #include <iostream>
 #include <cstring>
+#include <utility>
 #include "etcpal/netint.h"
 #include "etcpal/thread.h"
+#include "etcpal/timer.h"
 #include "rdmnet/cpp/common.h"
+#include "broker_flight_recorder.h"
 #include "broker_version.h"
 
+// How long the main loop sleeps between checks for shutdown and restart requests
+static constexpr uint32_t kRunLoopIntervalMs = 300u;
+
+// The longest a due restart is held off while the service is overloaded
+static constexpr uint32_t kMaxRestartDeferralMs = 60000u;
+
 bool BrokerShell::Init()
 {
   if (OpenLogFile())
@@ -33,7 +42,7 @@ bool BrokerShell::Init()
     if (log_.Startup(os_interface_))
     {
       LoadBrokerConfig();
-      log_.SetLogMask(broker_config_.log_mask);
+      ApplySettingsChanges();
       ready_to_run_ = true;
     }
   }
@@ -55,23 +64,35 @@ bool BrokerShell::Run()
   if (!rdmnet::Init(log_))
     return false;
 
+  BrokerFlightRecorder::Get().Record(BrokerEvent::kServiceStart);
+  watchdog_.Startup(log_);
+  const auto run_loop = watchdog_.AddLoop("BrokerShell::Run", kRunLoopIntervalMs);
+
   bool startup_broker = true;
+  bool broker_running = false;
   while (true)
   {
     if (startup_broker)
     {
       startup_broker = false;
+      watchdog_.Beat(run_loop, "broker startup");
 
-      if (broker_config_.enable_broker)
+      const auto current_config = config();
+      if (current_config->enable_broker)
       {
         if (etcpal_netint_refresh_interfaces() != kEtcPalErrOk)
           log_.Error("Error refreshing network interfaces - broker may not work correctly.");
 
-        auto res = broker_.Startup(broker_config_.settings, &log_, this);
-        if (!res)
+        auto res = broker_.Startup(current_config->settings, &log_, this);
+        if (res)
         {
+          broker_running = true;
+          BrokerFlightRecorder::Get().Record(BrokerEvent::kBrokerStarted);
+        }
+        else
+        {
+          BrokerFlightRecorder::Get().Record(BrokerEvent::kBrokerStartFailed, static_cast<uint32_t>(res.code()));
           log_.Notice("Broker startup failed (%s), running with broker functionality disabled.", res.ToCString());
-          broker_config_.enable_broker = false;
         }
       }
       else
@@ -86,10 +107,16 @@ bool BrokerShell::Run()
     }
     else if (TimeToRestartBroker())
     {
+      watchdog_.Beat(run_loop, "broker restart");
+      LogRestartRate();
       log_.Info("Restart requested, restarting broker and applying changes...");
 
-      if (broker_config_.enable_broker)
+      if (broker_running)
+      {
+        broker_running = false;
         broker_.Shutdown();
+        BrokerFlightRecorder::Get().Record(BrokerEvent::kBrokerStopped);
+      }
 
       LoadBrokerConfig();
       ApplySettingsChanges();
@@ -97,11 +124,25 @@ bool BrokerShell::Run()
       startup_broker = true;
     }
 
-    etcpal_thread_sleep(300);
+    watchdog_.Beat(run_loop, "idle");
+
+    // Oversleeping means this process isn't getting scheduled promptly, which is our overload signal.
+    const uint32_t sleep_start_ms = etcpal_getms();
+    etcpal_thread_sleep(kRunLoopIntervalMs);
+    const uint32_t slept_ms = etcpal_getms() - sleep_start_ms;
+    UpdateOverloadState((slept_ms > kRunLoopIntervalMs) ? slept_ms - kRunLoopIntervalMs : 0u);
   }
 
-  if (broker_config_.enable_broker)
+  watchdog_.Beat(run_loop, "broker shutdown");
+  if (broker_running)
+  {
     broker_.Shutdown();
+    BrokerFlightRecorder::Get().Record(BrokerEvent::kBrokerStopped);
+  }
+
+  watchdog_.LogStats();
+  watchdog_.Shutdown();
+  BrokerFlightRecorder::Get().Record(BrokerEvent::kServiceStop);
 
   rdmnet::Deinit();
   return true;
@@ -142,12 +183,15 @@ bool BrokerShell::OpenLogFile()
 
 void BrokerShell::LoadBrokerConfig()
 {
-  broker_config_.SetDefaults();  // Start with defaults - settings will be changed as needed.
+  // Build the new configuration privately, then publish it in one step. Copying the current one
+  // keeps its default CID, which is not stable between generations on every platform.
+  auto new_config = std::make_shared<BrokerConfig>(*config());
+  new_config->SetDefaults();  // Start with defaults - settings will be changed as needed.
 
   auto conf_file_pair = os_interface_.GetConfFile(log_);
   if (!conf_file_pair.second.is_open())
   {
-    broker_config_.enable_broker = false;
+    new_config->enable_broker = false;
     if (conf_file_pair.first.empty())
       log_.Notice("Error opening configuration file.");
     else
@@ -156,51 +200,133 @@ void BrokerShell::LoadBrokerConfig()
 
   log_.Info("Reading configuration file at %s...", conf_file_pair.first.c_str());
 
-  auto parse_res = broker_config_.Read(conf_file_pair.second, &log_);
+  auto parse_res = new_config->Read(conf_file_pair.second, &log_);
+  BrokerFlightRecorder::Get().Record(BrokerEvent::kConfigLoaded, static_cast<uint32_t>(parse_res));
 
   // kInvalidSetting is treated as non-fatal because it makes sure default values are used in place of invalid ones.
   if ((parse_res != BrokerConfig::ParseResult::kOk) && (parse_res != BrokerConfig::ParseResult::kInvalidSetting))
-    broker_config_.enable_broker = false;  // Error was already logged in the Read call above.
+    new_config->enable_broker = false;  // Error was already logged in the Read call above.
+
+  {
+    etcpal::MutexGuard guard(lock_);
+    if (!new_scope_.empty())
+    {
+      new_config->settings.scope = new_scope_;
+      new_scope_.clear();
+    }
+  }
+
+  PublishConfig(std::move(new_config));
+}
+
+void BrokerShell::PublishConfig(std::shared_ptr<const BrokerConfig> new_config)
+{
+  std::atomic_store(&config_, std::move(new_config));
 }
 
 void BrokerShell::HandleScopeChanged(const std::string& new_scope)
 {
   etcpal::MutexGuard guard(lock_);
   new_scope_ = new_scope;
+  BrokerFlightRecorder::Get().Record(BrokerEvent::kScopeChanged);
   LockedRequestRestart();
 }
 
 void BrokerShell::ApplySettingsChanges()
 {
-  etcpal::MutexGuard guard(lock_);
-
-  log_.SetLogMask(broker_config_.log_mask);
+  const auto current_config = config();
+  overload_monitor_.SetThresholds(current_config->overload_enter_lag_ms, current_config->overload_exit_lag_ms);
+  log_.SetLogMask(current_config->log_mask);
+}
 
-  if (!new_scope_.empty())
+bool BrokerShell::TimeToRestartBroker()
+{
+  bool restart_now = false;
+  bool deferral_started = false;
   {
-    broker_config_.settings.scope = new_scope_;
-    new_scope_.clear();
+    etcpal::MutexGuard guard(lock_);
+
+    // The timer is used to prevent "restart spamming" if tons of restarts are requested at once.
+    if (restart_requested_ && restart_timer_.IsExpired())
+    {
+      // While overloaded, hold off: every client reconnecting at once would only make things worse.
+      // The hold is limited so that configuration changes are still applied eventually.
+      if (overload_monitor_.overloaded() && !restart_deferred_)
+      {
+        restart_deferred_ = true;
+        restart_deferral_timer_.Start(kMaxRestartDeferralMs);
+        BrokerFlightRecorder::Get().Record(BrokerEvent::kRestartDeferred);
+        deferral_started = true;
+      }
+
+      if (!overload_monitor_.overloaded() || restart_deferral_timer_.IsExpired())
+      {
+        restart_deferred_ = false;
+        restart_requested_ = false;
+        restart_backoff_.OnRestart(etcpal_getms());
+        BrokerFlightRecorder::Get().Record(BrokerEvent::kRestart,
+                                           static_cast<uint32_t>(restart_backoff_.RestartsInWindow(etcpal_getms())));
+        restart_now = true;
+      }
+    }
   }
+
+  if (deferral_started)
+    log_.Notice("Service is overloaded - deferring broker restart for up to %u ms.", kMaxRestartDeferralMs);
+
+  return restart_now;
 }
 
-bool BrokerShell::TimeToRestartBroker()
+void BrokerShell::UpdateOverloadState(uint32_t lag_ms)
 {
-  etcpal::MutexGuard guard(lock_);
+  switch (overload_monitor_.Update(lag_ms, etcpal_getms()))
+  {
+    case BrokerOverloadMonitor::Transition::kEntered:
+      BrokerFlightRecorder::Get().Record(BrokerEvent::kOverloadEntered, lag_ms);
+      log_.Warning("Service is overloaded (scheduling lag %u ms) - deferring restarts.", lag_ms);
+      break;
+    case BrokerOverloadMonitor::Transition::kExited:
+    {
+      const uint32_t overloaded_ms = etcpal_getms() - overload_monitor_.overloaded_since_ms();
+      BrokerFlightRecorder::Get().Record(BrokerEvent::kOverloadExited, overloaded_ms);
+      log_.Notice("Service is no longer overloaded after %u ms.", overloaded_ms);
+      break;
+    }
+    default:
+      break;
+  }
+}
 
-  // The timer is used to prevent "restart spamming" if tons of restarts are requested at once.
-  if (restart_requested_ && restart_timer_.IsExpired())
+void BrokerShell::LogRestartRate()
+{
+  size_t   restarts_in_window = 0;
+  uint32_t backoff_ms = 0u;
   {
-    restart_requested_ = false;
-    return true;
+    etcpal::MutexGuard guard(lock_);
+    restarts_in_window = restart_backoff_.RestartsInWindow(etcpal_getms());
+    backoff_ms = restart_backoff_.current_backoff_ms();
   }
 
-  return false;
+  if (backoff_ms > 0u)
+  {
+    log_.Notice("Broker has restarted %zu times in the last %u minutes; further restarts will be held off for %u ms.",
+                restarts_in_window, BrokerRestartBackoff::kRateWindowMs / 60000u, backoff_ms);
+  }
+  else
+  {
+    log_.Info("Broker has restarted %zu times in the last %u minutes.", restarts_in_window,
+              BrokerRestartBackoff::kRateWindowMs / 60000u);
+  }
 }
 
 void BrokerShell::LockedRequestRestart(uint32_t cooldown_ms)
 {
   restart_requested_ = true;
 
+  // Back off further if restarts keep being requested, e.g. due to a flapping network link.
+  cooldown_ms = restart_backoff_.OnRestartRequested(etcpal_getms(), cooldown_ms);
+  BrokerFlightRecorder::Get().Record(BrokerEvent::kRestartRequested, cooldown_ms);
+
   if (cooldown_ms > restart_timer_.GetRemaining())  // Don't cancel out previous cooldown
     restart_timer_.Start(cooldown_ms);
 }
@@ -24,6 +24,7 @@
 #include <vector>
 #include <array>
 #include <atomic>
+#include <memory>
 #include "etcpal/inet.h"
 #include "etcpal/cpp/mutex.h"
 #include "etcpal/cpp/log.h"
@@ -31,6 +32,9 @@
 #include "rdmnet/cpp/broker.h"
 #include "broker_config.h"
 #include "broker_os_interface.h"
+#include "broker_overload_monitor.h"
+#include "broker_restart_backoff.h"
+#include "broker_watchdog.h"
 
 // BrokerShell : Platform-neutral wrapper around the Broker library from a generic console
 // application. Instantiates and drives the Broker library.
@@ -52,31 +56,47 @@ public:
 
   etcpal::Logger& log() { return log_; }
 
+  std::shared_ptr<const BrokerConfig> config() const { return std::atomic_load(&config_); }
+
 private:
   BrokerOsInterface& os_interface_;
   rdmnet::Broker     broker_;
   etcpal::Logger     log_;
+  BrokerWatchdog     watchdog_;
+
+  // The effective configuration. Each snapshot is immutable once published; a reload builds a new
+  // one and swaps it in. Readers on any thread don't take lock_ and always get one whole snapshot.
+  // Only access this through config() and PublishConfig().
+  std::shared_ptr<const BrokerConfig> config_{std::make_shared<const BrokerConfig>()};
 
-  BrokerConfig broker_config_;
+  bool              ready_to_run_{false};
+  std::atomic<bool> shutdown_requested_{false};
 
-  bool ready_to_run_{false};
+  // Only accessed from the Run() thread
+  BrokerOverloadMonitor overload_monitor_;
+  etcpal::Timer         restart_deferral_timer_;
+  bool                  restart_deferred_{false};
 
   // Handle changes at runtime
   mutable etcpal::Mutex lock_;  // These are guarded by this lock
   etcpal::Timer         restart_timer_;
+  BrokerRestartBackoff  restart_backoff_;
   bool                  restart_requested_{false};
-  bool                  shutdown_requested_{false};
   std::string           new_scope_;
 
   bool OpenLogFile();
   void LoadBrokerConfig();
+  void PublishConfig(std::shared_ptr<const BrokerConfig> new_config);
 
   void HandleScopeChanged(const std::string& new_scope) override;
   void PrintWarningMessage();
 
   void ApplySettingsChanges();
 
+  void UpdateOverloadState(uint32_t lag_ms);
+
   bool TimeToRestartBroker();
+  void LogRestartRate();
 
   void LockedRequestRestart(uint32_t cooldown_ms = 0u);
 };
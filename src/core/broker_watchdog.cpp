@@ -0,0 +1,219 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#include "broker_watchdog.h"
+
+#include <algorithm>
+#include "etcpal/thread.h"
+#include "etcpal/timer.h"
+#include "broker_flight_recorder.h"
+
+bool BrokerWatchdog::Startup(etcpal::Logger& log)
+{
+  if (running_)
+    return true;
+
+  log_ = &log;
+  running_ = true;
+  if (!thread_.Start([this]() { Run(); }).IsOk())
+  {
+    running_ = false;
+    log_->Warning("Could not start the watchdog thread - loop stalls will not be detected.");
+    return false;
+  }
+
+  return true;
+}
+
+void BrokerWatchdog::Shutdown()
+{
+  if (running_)
+  {
+    running_ = false;
+    thread_.Join();
+  }
+}
+
+void BrokerWatchdog::Run()
+{
+  while (running_)
+  {
+    Check(etcpal_getms());
+    BrokerFlightRecorder::Get().DumpIfRequested();
+    etcpal_thread_sleep(kCheckIntervalMs);
+  }
+}
+
+// Add a loop to be watched. expected_interval_ms is how often the loop is expected to beat when
+// it is running normally; beats later than this are counted as lag.
+BrokerWatchdog::LoopHandle BrokerWatchdog::AddLoop(const std::string& name, uint32_t expected_interval_ms)
+{
+  etcpal::MutexGuard guard(lock_);
+
+  Loop loop;
+  loop.stats.name = name;
+  loop.expected_interval_ms = expected_interval_ms;
+  loops_.push_back(loop);
+  return loops_.size() - 1;
+}
+
+// Signal that a loop is alive and about to enter the given phase. The phase string must have
+// static storage duration.
+void BrokerWatchdog::Beat(LoopHandle loop, const char* phase)
+{
+  Beat(loop, phase, etcpal_getms());
+}
+
+void BrokerWatchdog::Beat(LoopHandle loop_handle, const char* phase, uint32_t now_ms)
+{
+  bool        recovered = false;
+  std::string loop_name;
+  uint32_t    interval = 0u;
+  {
+    etcpal::MutexGuard guard(lock_);
+
+    if (loop_handle >= loops_.size())
+      return;
+
+    Loop& loop = loops_[loop_handle];
+    if (loop.started)
+    {
+      interval = now_ms - loop.last_beat_ms;
+      const uint32_t lag = (interval > loop.expected_interval_ms) ? interval - loop.expected_interval_ms : 0u;
+      ++loop.stats.lag_histogram[LagBucket(lag)];
+      loop.stats.max_lag_ms = std::max(loop.stats.max_lag_ms, lag);
+
+      if (loop.stalled)
+      {
+        recovered = true;
+        loop_name = loop.stats.name;
+      }
+    }
+
+    loop.started = true;
+    loop.last_beat_ms = now_ms;
+    loop.phase = phase ? phase : "";
+    loop.stalled = false;
+  }
+
+  // Log outside the lock, so a slow log handler can't hold up other loops' beats.
+  if (recovered && log_)
+    log_->Warning("Watchdog: loop \"%s\" recovered after stalling for %u ms.", loop_name.c_str(), interval);
+}
+
+// Check all loops for stalls, logging any newly-stalled loops. Returns the number of loops that are
+// currently stalled. This is called periodically from the watchdog thread.
+size_t BrokerWatchdog::Check(uint32_t now_ms)
+{
+  struct NewStall
+  {
+    size_t      index;
+    std::string name;
+    const char* phase;
+    uint32_t    since_last_beat_ms;
+  };
+  std::vector<NewStall> new_stalls;
+
+  size_t num_stalled = 0;
+  {
+    etcpal::MutexGuard guard(lock_);
+
+    for (size_t i = 0; i < loops_.size(); ++i)
+    {
+      Loop& loop = loops_[i];
+      if (!loop.started)
+        continue;
+
+      // A beat may have landed between the caller reading the clock and taking the lock; the
+      // signed cast catches that case after the unsigned subtraction wraps.
+      const uint32_t since_last_beat = now_ms - loop.last_beat_ms;
+      if ((static_cast<int32_t>(since_last_beat) < 0) ||
+          (since_last_beat <= loop.expected_interval_ms + stall_threshold_ms_))
+      {
+        continue;
+      }
+
+      ++num_stalled;
+      if (!loop.stalled)
+      {
+        // Only report once per stall; the recovery is logged by the next Beat().
+        loop.stalled = true;
+        ++loop.stats.stall_count;
+        new_stalls.push_back(NewStall{i, loop.stats.name, loop.phase, since_last_beat});
+      }
+    }
+  }
+
+  // Report outside the lock, so a slow log handler can't block the loops being watched.
+  for (const auto& stall : new_stalls)
+  {
+    BrokerFlightRecorder::Get().Record(BrokerEvent::kLoopStall, static_cast<uint32_t>(stall.index),
+                                       stall.since_last_beat_ms);
+    if (log_)
+    {
+      log_->Warning("Watchdog: loop \"%s\" has not run for %u ms; it is stuck in phase \"%s\".", stall.name.c_str(),
+                    stall.since_last_beat_ms, stall.phase);
+    }
+  }
+
+  return num_stalled;
+}
+
+std::vector<BrokerWatchdog::LoopStats> BrokerWatchdog::GetStats() const
+{
+  etcpal::MutexGuard guard(lock_);
+
+  std::vector<LoopStats> stats;
+  stats.reserve(loops_.size());
+  for (const auto& loop : loops_)
+    stats.push_back(loop.stats);
+  return stats;
+}
+
+// Log the lag histogram of each loop, in the form "<10ms: 123, <50ms: 4, ..., >=5000ms: 0".
+void BrokerWatchdog::LogStats() const
+{
+  if (!log_)
+    return;
+
+  for (const auto& loop : GetStats())
+  {
+    std::string histogram;
+    for (size_t i = 0; i < kNumLagBuckets; ++i)
+    {
+      if (!histogram.empty())
+        histogram += ", ";
+
+      if (i < kLagBucketLimitsMs.size())
+        histogram += "<" + std::to_string(kLagBucketLimitsMs[i]) + "ms: ";
+      else
+        histogram += ">=" + std::to_string(kLagBucketLimitsMs.back()) + "ms: ";
+      histogram += std::to_string(loop.lag_histogram[i]);
+    }
+
+    log_->Info("Watchdog: loop \"%s\" lag histogram {%s}, max lag %u ms, %llu stall(s).", loop.name.c_str(),
+               histogram.c_str(), loop.max_lag_ms, static_cast<unsigned long long>(loop.stall_count));
+  }
+}
+
+size_t BrokerWatchdog::LagBucket(uint32_t lag_ms)
+{
+  return static_cast<size_t>(std::upper_bound(kLagBucketLimitsMs.begin(), kLagBucketLimitsMs.end(), lag_ms) -
+                             kLagBucketLimitsMs.begin());
+}
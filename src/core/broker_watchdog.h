@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#ifndef BROKER_WATCHDOG_H_
+#define BROKER_WATCHDOG_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "etcpal/cpp/log.h"
+#include "etcpal/cpp/mutex.h"
+#include "etcpal/cpp/thread.h"
+
+// BrokerWatchdog : Watches the service's loops for stalls.
+//
+// Each watched loop calls Beat() once per iteration, naming the phase it is about to enter. The
+// watchdog records how late each beat was relative to the loop's expected interval in a lag
+// histogram. A separate thread checks the loops periodically, and logs the phase a loop is stuck
+// in once it has gone longer than the stall threshold without a beat.
+class BrokerWatchdog
+{
+public:
+  static constexpr uint32_t kDefaultStallThresholdMs = 2000u;
+  static constexpr uint32_t kCheckIntervalMs = 100u;
+
+  // Upper bounds (exclusive) of the lag histogram buckets, in ms. The last bucket is unbounded.
+  static constexpr std::array<uint32_t, 8> kLagBucketLimitsMs = {10u, 50u, 100u, 250u, 500u, 1000u, 2500u, 5000u};
+  static constexpr size_t                  kNumLagBuckets = kLagBucketLimitsMs.size() + 1u;
+
+  struct LoopStats
+  {
+    std::string                          name;
+    std::array<uint64_t, kNumLagBuckets> lag_histogram{};
+    uint32_t                             max_lag_ms{0u};
+    uint64_t                             stall_count{0u};
+  };
+
+  using LoopHandle = size_t;
+
+  BrokerWatchdog(uint32_t stall_threshold_ms = kDefaultStallThresholdMs) : stall_threshold_ms_(stall_threshold_ms) {}
+  ~BrokerWatchdog() { Shutdown(); }
+
+  bool Startup(etcpal::Logger& log);
+  void Shutdown();
+
+  LoopHandle AddLoop(const std::string& name, uint32_t expected_interval_ms);
+  void       Beat(LoopHandle loop, const char* phase);
+  void       Beat(LoopHandle loop, const char* phase, uint32_t now_ms);
+
+  size_t                 Check(uint32_t now_ms);
+  std::vector<LoopStats> GetStats() const;
+  void                   LogStats() const;
+
+private:
+  struct Loop
+  {
+    LoopStats   stats;
+    uint32_t    expected_interval_ms{0u};
+    bool        started{false};
+    uint32_t    last_beat_ms{0u};
+    const char* phase{""};
+    bool        stalled{false};
+  };
+
+  const uint32_t stall_threshold_ms_;
+
+  etcpal::Logger*   log_{nullptr};
+  etcpal::Thread    thread_;
+  std::atomic<bool> running_{false};
+
+  mutable etcpal::Mutex lock_;  // Guards loops_
+  std::vector<Loop>     loops_;
+
+  void          Run();
+  static size_t LagBucket(uint32_t lag_ms);
+};
+
+#endif  // BROKER_WATCHDOG_H_
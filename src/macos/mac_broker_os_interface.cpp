@@ -19,6 +19,7 @@
 
 #include "mac_broker_os_interface.h"
 
+#include "broker_flight_recorder.h"
 #include "broker_version.h"
 
 #include <cmath>
@@ -40,6 +41,7 @@ static constexpr mode_t kLogFileMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
 
 static constexpr char* kLogFilePath = "/usr/local/var/log/RDMnetBroker/broker.log";
 static constexpr char* kConfigFilePath = "/usr/local/etc/RDMnetBroker/broker.conf";
+static constexpr char* kFlightRecorderDumpPath = "/usr/local/var/log/RDMnetBroker/broker_flight_recorder.bin";
 
 static constexpr int kMaxLogRotationFiles = 5;
 
@@ -131,6 +133,7 @@ bool MacBrokerOsInterface::OpenLogFile()
     return false;
 
   log_stream_.open(GetLogFilePath());
+  BrokerFlightRecorder::Get().SetDumpPath(kFlightRecorderDumpPath);
 
   // Write an initial message to the log file
   auto time = GetLogTimestamp();
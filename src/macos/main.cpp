@@ -20,6 +20,7 @@
 // The MacOS entry point for the broker service.
 
 #include <signal.h>
+#include "broker_flight_recorder.h"
 #include "broker_service.h"
 
 #include <iostream>
@@ -31,6 +32,17 @@ void HandleSignal(int signum)
 {
   if (signum == SIGTERM)
     service.AsyncShutdown();
+  else if (signum == SIGUSR1)
+    BrokerFlightRecorder::Get().RequestDump();  // Dumping here could deadlock a healthy process
+}
+
+void HandleFatalSignal(int signum)
+{
+  BrokerFlightRecorder::Get().DumpToFile();
+
+  // Re-raise with the default action so the crash is still reported normally.
+  signal(signum, SIG_DFL);
+  raise(signum);
 }
 
 int main()
@@ -41,6 +53,11 @@ int main()
   // As a launchd daemon, we must set up a SIGTERM handler
   signal(SIGTERM, HandleSignal);
 
+  // The flight recorder is dumped on demand with SIGUSR1, and when we crash.
+  signal(SIGUSR1, HandleSignal);
+  for (int fatal_signal : {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT})
+    signal(fatal_signal, HandleFatalSignal);
+
   int retval = EXIT_SUCCESS;
   if (!service.Run())
     retval = EXIT_FAILURE;
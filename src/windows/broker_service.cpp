@@ -19,6 +19,7 @@
 
 #include "broker_service.h"
 #include "broker_common.h"
+#include "broker_flight_recorder.h"
 #include <iostream>
 #include <strsafe.h>
 #include <system_error>
@@ -26,6 +27,10 @@
 // The interval to wait before restarting (in case we get blasted with tons of notifications at once)
 static constexpr uint32_t kNetworkChangeCooldownMs = 5000u;
 
+// User-defined service control code that dumps the flight recorder, e.g.:
+// sc control "ETC RDMnet Broker" 128
+static constexpr DWORD kServiceControlDumpFlightRecorder = 128u;
+
 BrokerService* BrokerService::service_{nullptr};
 
 auto assert_log_fn = [](const char* msg) { std::cout << msg << "\n"; };
@@ -240,7 +245,7 @@ void WINAPI BrokerService::ServiceMain(DWORD argc, PWSTR* argv)
 //     SERVICE_CONTROL_STOP
 //
 //   This parameter can also be a user-defined control code ranges from 128
-//   to 255.
+//   to 255. kServiceControlDumpFlightRecorder is handled here.
 //
 void WINAPI BrokerService::ServiceCtrlHandler(DWORD control_code)
 {
@@ -255,6 +260,9 @@ void WINAPI BrokerService::ServiceCtrlHandler(DWORD control_code)
     case SERVICE_CONTROL_SHUTDOWN:
       service_->Shutdown();
       break;
+    case kServiceControlDumpFlightRecorder:
+      BrokerFlightRecorder::Get().DumpToFile();
+      break;
     default:
       break;
   }
@@ -27,6 +27,7 @@
 #include "service_config.h"
 #include "service_utils.h"
 #include "broker_common.h"
+#include "broker_flight_recorder.h"
 #include "broker_service.h"
 #include "broker_version.h"
 
@@ -47,10 +48,18 @@ void PrintUsage(const wchar_t* app_name)
   std::wprintf(L"  -version  Print version information and exit.\n");
 }
 
+LONG WINAPI HandleUnhandledException(EXCEPTION_POINTERS* /*exception_info*/)
+{
+  BrokerFlightRecorder::Get().DumpToFile();
+  return EXCEPTION_CONTINUE_SEARCH;  // Let the default crash handling proceed
+}
+
 int wmain(int argc, wchar_t* argv[])
 {
   bool debug_mode = false;
 
+  SetUnhandledExceptionFilter(HandleUnhandledException);
+
   auto service = std::make_unique<BrokerService>(kServiceName);
   if (!service)
   {
@@ -26,12 +26,14 @@
 #include <datetimeapi.h>
 #include "service_utils.h"
 #include "broker_common.h"
+#include "broker_flight_recorder.h"
 #include "broker_version.h"
 
 constexpr const WCHAR                  kRelativeConfDirName[] = L"\\ETC\\RDMnetBroker\\Config";
 constexpr const WCHAR                  kConfFileName[] = L"broker.conf";
 static const std::vector<std::wstring> kRelativeLogFilePath = {L"ETC", L"RDMnetBroker", L"Logs"};
 static const std::wstring              kLogFileName = L"broker.log";
+static const std::wstring              kFlightRecorderDumpFileName = L"broker_flight_recorder.bin";
 static constexpr int                   kMaxLogRotationFiles = 5;
 
 std::string ConvertWstringToUtf8(const std::wstring& str)
@@ -119,6 +121,10 @@ bool WindowsBrokerOsInterface::OpenLogFile()
     }
   }
 
+  // The flight recorder dump lives alongside the logs.
+  const std::wstring dump_path = intermediate_dir_path + L"\\" + kFlightRecorderDumpFileName;
+  BrokerFlightRecorder::Get().SetDumpPath(dump_path);
+
   DWORD rotate_result = RotateLogs();
 
   log_file_ = _wfsopen(log_file_path_.c_str(), L"w", _SH_DENYWR);
@@ -658,6 +658,34 @@ TEST_F(TestBrokerConfig, ValidMaxRejectConnectionsParsedCorrectly)
                                   [](const auto& settings) { return settings.limits.reject_connections; });
 }
 
+TEST_F(TestBrokerConfig, InvalidOverloadEnterLagValueShouldFail)
+{
+  TestInvalidUnsignedIntValueHelper("overload_enter_lag_ms");
+}
+
+TEST_F(TestBrokerConfig, ValidOverloadLagThresholdsParsedCorrectly)
+{
+  std::istringstream test_stream(R"({ "overload_enter_lag_ms": 500, "overload_exit_lag_ms": 100 })");
+  ASSERT_EQ(config_.Read(test_stream), BrokerConfig::ParseResult::kOk);
+  EXPECT_EQ(config_.overload_enter_lag_ms, 500u);
+  EXPECT_EQ(config_.overload_exit_lag_ms, 100u);
+}
+
+TEST_F(TestBrokerConfig, InvalidOverloadExitLagValueShouldFail)
+{
+  TestInvalidUnsignedIntValueHelper("overload_exit_lag_ms");
+}
+
+// The overload monitor clamps the exit threshold to the enter threshold, so the config accepts
+// them in any combination. In particular, this is how the README says to disable detection.
+TEST_F(TestBrokerConfig, OverloadDetectionCanBeDisabled)
+{
+  std::istringstream test_stream(R"({ "overload_enter_lag_ms": 0, "overload_exit_lag_ms": 250 })");
+  ASSERT_EQ(config_.Read(test_stream), BrokerConfig::ParseResult::kOk);
+  EXPECT_EQ(config_.overload_enter_lag_ms, 0u);
+  EXPECT_EQ(config_.overload_exit_lag_ms, 250u);
+}
+
 TEST_F(TestBrokerConfig, SetDefaultsRestoresDefaultsConsistently)
 {
   // Generate defaults to compare against later from a freshly-constructed config
@@ -679,6 +707,8 @@ TEST_F(TestBrokerConfig, SetDefaultsRestoresDefaultsConsistently)
   config_.settings.scope = "test123";
   config_.settings.listen_port = 1234u;
   config_.settings.listen_interfaces.push_back("eth0");
+  config_.overload_enter_lag_ms = 7u;
+  config_.overload_exit_lag_ms = 8u;
 
   // Now try restoring defaults again and verify they're the same as the original defaults
   config_.SetDefaults();
@@ -697,4 +727,6 @@ TEST_F(TestBrokerConfig, SetDefaultsRestoresDefaultsConsistently)
   EXPECT_EQ(config_.settings.listen_interfaces, initial_defaults.settings.listen_interfaces);
   EXPECT_EQ(config_.log_mask, initial_defaults.log_mask);
   EXPECT_EQ(config_.enable_broker, initial_defaults.enable_broker);
+  EXPECT_EQ(config_.overload_enter_lag_ms, initial_defaults.overload_enter_lag_ms);
+  EXPECT_EQ(config_.overload_exit_lag_ms, initial_defaults.overload_exit_lag_ms);
 }
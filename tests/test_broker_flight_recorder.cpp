@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#include "broker_flight_recorder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+
+using DumpRecord = BrokerFlightRecorder::DumpRecord;
+
+constexpr const char* kDumpPath = "test_broker_flight_recorder.bin";
+
+class TestBrokerFlightRecorder : public testing::Test
+{
+protected:
+  void TearDown() override { std::remove(kDumpPath); }
+
+  static BrokerFlightRecorder::PathString DumpPath()
+  {
+    return BrokerFlightRecorder::PathString(kDumpPath, kDumpPath + std::strlen(kDumpPath));
+  }
+
+  // Dump the recorder to a file and parse the records back out of it.
+  std::vector<DumpRecord> DumpAndParse()
+  {
+    std::vector<DumpRecord> records;
+
+    recorder_->SetDumpPath(DumpPath());
+    EXPECT_TRUE(recorder_->DumpToFile());
+
+    std::FILE* file = std::fopen(kDumpPath, "rb");
+    if (!file)
+    {
+      ADD_FAILURE() << "Could not open the dump file";
+      return records;
+    }
+
+    char     magic[8];
+    uint32_t header_fields[2];
+    EXPECT_EQ(std::fread(magic, sizeof(magic), 1, file), 1u);
+    EXPECT_EQ(std::memcmp(magic, "RDMBFR01", sizeof(magic)), 0);
+    EXPECT_EQ(std::fread(header_fields, sizeof(header_fields), 1, file), 1u);
+    EXPECT_EQ(header_fields[0], sizeof(DumpRecord));
+
+    DumpRecord record;
+    while (std::fread(&record, sizeof(record), 1, file) == 1)
+      records.push_back(record);
+
+    std::fclose(file);
+    return records;
+  }
+
+  // The ring is large, so keep it off the stack.
+  std::unique_ptr<BrokerFlightRecorder> recorder_{std::make_unique<BrokerFlightRecorder>()};
+};
+
+TEST_F(TestBrokerFlightRecorder, EmptyRecorderDumpsHeaderOnly)
+{
+  EXPECT_TRUE(DumpAndParse().empty());
+}
+
+TEST_F(TestBrokerFlightRecorder, DumpsRecordedEventsInOrder)
+{
+  recorder_->Record(BrokerEvent::kServiceStart, 0u, 0u, 100u);
+  recorder_->Record(BrokerEvent::kRestartRequested, 5000u, 0u, 200u);
+  recorder_->Record(BrokerEvent::kLoopStall, 1u, 2500u, 300u);
+
+  const auto records = DumpAndParse();
+  ASSERT_EQ(records.size(), 3u);
+
+  EXPECT_EQ(records[0].sequence, 0u);
+  EXPECT_EQ(records[0].time_ms, 100u);
+  EXPECT_EQ(records[0].event, static_cast<uint16_t>(BrokerEvent::kServiceStart));
+
+  EXPECT_EQ(records[1].sequence, 1u);
+  EXPECT_EQ(records[1].event, static_cast<uint16_t>(BrokerEvent::kRestartRequested));
+  EXPECT_EQ(records[1].arg1, 5000u);
+
+  EXPECT_EQ(records[2].sequence, 2u);
+  EXPECT_EQ(records[2].time_ms, 300u);
+  EXPECT_EQ(records[2].event, static_cast<uint16_t>(BrokerEvent::kLoopStall));
+  EXPECT_EQ(records[2].arg1, 1u);
+  EXPECT_EQ(records[2].arg2, 2500u);
+}
+
+TEST_F(TestBrokerFlightRecorder, OldestEventsAreOverwritten)
+{
+  const uint32_t kNumEvents = BrokerFlightRecorder::kCapacity + 10u;
+  for (uint32_t i = 0; i < kNumEvents; ++i)
+    recorder_->Record(BrokerEvent::kRestart, i, 0u, i);
+
+  EXPECT_EQ(recorder_->total_recorded(), kNumEvents);
+
+  const auto records = DumpAndParse();
+  ASSERT_EQ(records.size(), BrokerFlightRecorder::kCapacity);
+  EXPECT_EQ(records.front().sequence, 10u);
+  EXPECT_EQ(records.front().arg1, 10u);
+  EXPECT_EQ(records.back().sequence, kNumEvents - 1u);
+  EXPECT_EQ(records.back().arg1, kNumEvents - 1u);
+}
+
+TEST_F(TestBrokerFlightRecorder, DumpToFileFailsWithoutPath)
+{
+  recorder_->Record(BrokerEvent::kServiceStart);
+  EXPECT_FALSE(recorder_->DumpToFile());
+}
+
+TEST_F(TestBrokerFlightRecorder, DumpsOnlyWhenRequested)
+{
+  recorder_->SetDumpPath(DumpPath());
+  recorder_->Record(BrokerEvent::kServiceStart);
+
+  EXPECT_FALSE(recorder_->DumpIfRequested());
+  recorder_->RequestDump();
+  EXPECT_TRUE(recorder_->DumpIfRequested());
+  EXPECT_FALSE(recorder_->DumpIfRequested());
+}
+
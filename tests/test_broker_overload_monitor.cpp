@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#include "broker_overload_monitor.h"
+
+#include "gtest/gtest.h"
+
+using Transition = BrokerOverloadMonitor::Transition;
+
+constexpr uint32_t kEnterLagMs = 1000u;
+constexpr uint32_t kExitLagMs = 200u;
+constexpr uint32_t kSampleIntervalMs = 300u;
+
+class TestBrokerOverloadMonitor : public testing::Test
+{
+protected:
+  TestBrokerOverloadMonitor() { monitor_.SetThresholds(kEnterLagMs, kExitLagMs); }
+
+  Transition Sample(uint32_t lag_ms)
+  {
+    now_ms_ += kSampleIntervalMs + lag_ms;
+    return monitor_.Update(lag_ms, now_ms_);
+  }
+
+  void EnterOverload()
+  {
+    for (uint32_t i = 1; i < BrokerOverloadMonitor::kEnterSamples; ++i)
+      ASSERT_EQ(Sample(kEnterLagMs), Transition::kNone);
+    ASSERT_EQ(Sample(kEnterLagMs), Transition::kEntered);
+  }
+
+  BrokerOverloadMonitor monitor_;
+  uint32_t              now_ms_{0u};
+};
+
+TEST_F(TestBrokerOverloadMonitor, SingleSpikeDoesNotEnterOverload)
+{
+  EXPECT_EQ(Sample(kEnterLagMs * 5u), Transition::kNone);
+  EXPECT_EQ(Sample(0u), Transition::kNone);
+  EXPECT_EQ(Sample(kEnterLagMs * 5u), Transition::kNone);
+  EXPECT_FALSE(monitor_.overloaded());
+}
+
+TEST_F(TestBrokerOverloadMonitor, SustainedLagEntersOverload)
+{
+  EnterOverload();
+  EXPECT_TRUE(monitor_.overloaded());
+  EXPECT_EQ(monitor_.overloaded_since_ms(), now_ms_);
+}
+
+TEST_F(TestBrokerOverloadMonitor, ExitsOnlyAfterHoldTimeBelowExitThreshold)
+{
+  EnterOverload();
+
+  // Lag between the thresholds keeps us overloaded indefinitely.
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(Sample(kExitLagMs + 1u), Transition::kNone);
+  EXPECT_TRUE(monitor_.overloaded());
+
+  const uint32_t calm_start = now_ms_;
+  Transition     transition = Transition::kNone;
+  while (transition == Transition::kNone)
+  {
+    transition = Sample(kExitLagMs);
+    if (transition == Transition::kNone)
+    {
+      EXPECT_LT(now_ms_ - calm_start, BrokerOverloadMonitor::kExitHoldMs + 2u * kSampleIntervalMs);
+    }
+  }
+  EXPECT_EQ(transition, Transition::kExited);
+  EXPECT_FALSE(monitor_.overloaded());
+}
+
+TEST_F(TestBrokerOverloadMonitor, HighSampleRestartsExitHold)
+{
+  EnterOverload();
+
+  for (uint32_t elapsed = 0; elapsed < BrokerOverloadMonitor::kExitHoldMs / 2u; elapsed += kSampleIntervalMs)
+    EXPECT_EQ(Sample(0u), Transition::kNone);
+  EXPECT_EQ(Sample(kExitLagMs + 1u), Transition::kNone);
+  for (uint32_t elapsed = 0; elapsed < BrokerOverloadMonitor::kExitHoldMs / 2u; elapsed += kSampleIntervalMs)
+    EXPECT_EQ(Sample(0u), Transition::kNone);
+
+  EXPECT_TRUE(monitor_.overloaded());
+}
+
+TEST_F(TestBrokerOverloadMonitor, ZeroEnterThresholdDisablesDetection)
+{
+  EnterOverload();
+  monitor_.SetThresholds(0u, 0u);
+  EXPECT_EQ(Sample(kEnterLagMs), Transition::kExited);
+
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(Sample(kEnterLagMs * 10u), Transition::kNone);
+  EXPECT_FALSE(monitor_.overloaded());
+}
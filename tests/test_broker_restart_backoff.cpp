@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#include "broker_restart_backoff.h"
+
+#include "gtest/gtest.h"
+
+constexpr uint32_t kInitialBackoffMs = 5000u;
+constexpr uint32_t kMaxBackoffMs = 40000u;
+constexpr uint32_t kQuietPeriodMs = 60000u;
+
+class TestBrokerRestartBackoff : public testing::Test
+{
+protected:
+  // Request a restart at now_ms_ and perform it once the returned cooldown has elapsed.
+  uint32_t RequestAndRestart(uint32_t requested_cooldown_ms = 0u)
+  {
+    const uint32_t cooldown = backoff_.OnRestartRequested(now_ms_, requested_cooldown_ms);
+    now_ms_ += cooldown;
+    backoff_.OnRestart(now_ms_);
+    return cooldown;
+  }
+
+  BrokerRestartBackoff backoff_{kInitialBackoffMs, kMaxBackoffMs, kQuietPeriodMs};
+  uint32_t             now_ms_{1000u};
+};
+
+TEST_F(TestBrokerRestartBackoff, FirstRequestUsesRequestedCooldown)
+{
+  EXPECT_EQ(backoff_.OnRestartRequested(now_ms_, 0u), 0u);
+  EXPECT_EQ(backoff_.OnRestartRequested(now_ms_, 3000u), 3000u);
+  EXPECT_EQ(backoff_.current_backoff_ms(), 0u);
+}
+
+TEST_F(TestBrokerRestartBackoff, BacksOffExponentiallyWhileFlapping)
+{
+  EXPECT_EQ(RequestAndRestart(), 0u);
+
+  now_ms_ += 1000u;
+  EXPECT_EQ(RequestAndRestart(), kInitialBackoffMs);
+  now_ms_ += 1000u;
+  EXPECT_EQ(RequestAndRestart(), kInitialBackoffMs * 2u);
+  now_ms_ += 1000u;
+  EXPECT_EQ(RequestAndRestart(), kInitialBackoffMs * 4u);
+  now_ms_ += 1000u;
+  EXPECT_EQ(RequestAndRestart(), kMaxBackoffMs);
+  now_ms_ += 1000u;
+  EXPECT_EQ(RequestAndRestart(), kMaxBackoffMs);
+}
+
+TEST_F(TestBrokerRestartBackoff, BurstOfRequestsEscalatesOnce)
+{
+  RequestAndRestart();
+
+  // e.g. several file change notifications for a single save
+  now_ms_ += 1000u;
+  for (int i = 0; i < 6; ++i)
+  {
+    EXPECT_EQ(backoff_.OnRestartRequested(now_ms_, 0u), kInitialBackoffMs);
+    now_ms_ += 1u;
+  }
+  backoff_.OnRestart(now_ms_);
+
+  now_ms_ += 1000u;
+  for (int i = 0; i < 6; ++i)
+  {
+    EXPECT_EQ(backoff_.OnRestartRequested(now_ms_, 0u), kInitialBackoffMs * 2u);
+    now_ms_ += 1u;
+  }
+}
+
+TEST_F(TestBrokerRestartBackoff, RequestedCooldownIsNeverShortened)
+{
+  RequestAndRestart();
+  now_ms_ += 1000u;
+  EXPECT_EQ(backoff_.OnRestartRequested(now_ms_, kInitialBackoffMs * 3u), kInitialBackoffMs * 3u);
+}
+
+TEST_F(TestBrokerRestartBackoff, ResetsAfterQuietPeriod)
+{
+  RequestAndRestart();
+  now_ms_ += 1000u;
+  RequestAndRestart();
+  now_ms_ += 1000u;
+  RequestAndRestart();
+  ASSERT_GT(backoff_.current_backoff_ms(), 0u);
+
+  now_ms_ += kQuietPeriodMs;
+  EXPECT_EQ(backoff_.OnRestartRequested(now_ms_, 0u), 0u);
+  EXPECT_EQ(backoff_.current_backoff_ms(), 0u);
+}
+
+TEST_F(TestBrokerRestartBackoff, HandlesClockWraparound)
+{
+  now_ms_ = 0xffffffffu - 500u;
+  RequestAndRestart();
+  now_ms_ += 1000u;  // Wraps
+  EXPECT_EQ(RequestAndRestart(), kInitialBackoffMs);
+  EXPECT_EQ(backoff_.RestartsInWindow(now_ms_), 2u);
+}
+
+TEST_F(TestBrokerRestartBackoff, ReportsRestartsInWindow)
+{
+  EXPECT_EQ(backoff_.RestartsInWindow(now_ms_), 0u);
+
+  RequestAndRestart();
+  now_ms_ += 1000u;
+  RequestAndRestart();
+  EXPECT_EQ(backoff_.RestartsInWindow(now_ms_), 2u);
+  EXPECT_EQ(backoff_.total_restarts(), 2u);
+
+  now_ms_ += BrokerRestartBackoff::kRateWindowMs;
+  EXPECT_EQ(backoff_.RestartsInWindow(now_ms_), 0u);
+  EXPECT_EQ(backoff_.total_restarts(), 2u);
+}
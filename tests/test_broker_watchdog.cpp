@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnetBroker. For more information, go to:
+ * https://github.com/ETCLabs/RDMnetBroker
+ *****************************************************************************/
+
+#include "broker_watchdog.h"
+
+#include "gtest/gtest.h"
+
+constexpr uint32_t kStallThresholdMs = 1000u;
+constexpr uint32_t kLoopIntervalMs = 100u;
+
+// These tests drive Beat() and Check() with explicit times and never start the watchdog thread.
+class TestBrokerWatchdog : public testing::Test
+{
+protected:
+  BrokerWatchdog             watchdog_{kStallThresholdMs};
+  BrokerWatchdog::LoopHandle loop_{watchdog_.AddLoop("test loop", kLoopIntervalMs)};
+};
+
+TEST_F(TestBrokerWatchdog, LoopIsNotStalledBeforeFirstBeat)
+{
+  EXPECT_EQ(watchdog_.Check(1000000u), 0u);
+}
+
+TEST_F(TestBrokerWatchdog, DetectsStallAfterThreshold)
+{
+  watchdog_.Beat(loop_, "phase", 1000u);
+  EXPECT_EQ(watchdog_.Check(1000u + kLoopIntervalMs + kStallThresholdMs), 0u);
+  EXPECT_EQ(watchdog_.Check(1000u + kLoopIntervalMs + kStallThresholdMs + 1u), 1u);
+
+  // A stall is only counted once, no matter how many checks see it.
+  EXPECT_EQ(watchdog_.Check(1000u + 10u * kStallThresholdMs), 1u);
+  EXPECT_EQ(watchdog_.GetStats()[0].stall_count, 1u);
+
+  watchdog_.Beat(loop_, "phase", 1000u + 10u * kStallThresholdMs);
+  EXPECT_EQ(watchdog_.Check(1000u + 10u * kStallThresholdMs), 0u);
+}
+
+TEST_F(TestBrokerWatchdog, BeatAfterCheckTimeIsNotAStall)
+{
+  watchdog_.Beat(loop_, "phase", 1000u);
+  EXPECT_EQ(watchdog_.Check(999u), 0u);
+}
+
+TEST_F(TestBrokerWatchdog, RecordsLagHistogram)
+{
+  uint32_t now = 1000u;
+  watchdog_.Beat(loop_, "phase", now);
+  now += kLoopIntervalMs;  // On time: lag 0
+  watchdog_.Beat(loop_, "phase", now);
+  now += kLoopIntervalMs + 300u;  // Lag 300
+  watchdog_.Beat(loop_, "phase", now);
+  now += kLoopIntervalMs + 6000u;  // Lag 6000
+  watchdog_.Beat(loop_, "phase", now);
+
+  const auto stats = watchdog_.GetStats();
+  ASSERT_EQ(stats.size(), 1u);
+  EXPECT_EQ(stats[0].name, "test loop");
+  EXPECT_EQ(stats[0].lag_histogram[0], 1u);                                   // < 10 ms
+  EXPECT_EQ(stats[0].lag_histogram[4], 1u);                                   // < 500 ms
+  EXPECT_EQ(stats[0].lag_histogram[BrokerWatchdog::kNumLagBuckets - 1], 1u);  // >= 5000 ms
+  EXPECT_EQ(stats[0].max_lag_ms, 6000u);
+}